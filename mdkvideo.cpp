@@ -15,8 +15,14 @@ using namespace Microsoft::WRL; //ComPtr
 # define HAS_ON_AUDIO 1
 #endif
 using namespace MDK_NS;
+#include <atomic>
+#include <cctype>
+#include <deque>
 #include <list>
+#include <map>
+#include <mutex>
 #include <regex>
+#include <set>
 using namespace std;
 
 #define S_PLAYLIST "playlist"
@@ -41,6 +47,10 @@ using namespace std;
 #define EXTENSIONS_MEDIA \
 	EXTENSIONS_VIDEO " " EXTENSIONS_PLAYLIST
 
+// numbered frames in a folder are played as one clip by ffmpeg image2 demuxer
+#define EXTENSIONS_IMAGE \
+	"*.bmp *.dpx *.exr *.jpeg *.jpg *.png *.tga *.tif *.tiff *.webp"
+
 #define MS_ENSURE(f, ...) MS_CHECK(f, return __VA_ARGS__;)
 #define MS_WARN(f) MS_CHECK(f)
 #define MS_CHECK(f, ...)  do { \
@@ -53,6 +63,10 @@ using namespace std;
     } while (false)
 
 constexpr int kMaxSpeedPercent = 400;
+constexpr int kMaxReplaySeconds = 60;
+constexpr int kMaxFrameCacheMB = 8192;
+constexpr int kTrackAuto = -1; // libmdk default: the 1st track
+constexpr int kTrackNone = -2;
 
 auto from_obs(gs_color_space cs) {
     switch (cs)
@@ -125,6 +139,98 @@ static inline enum speaker_layout convert_speaker_layout(uint8_t channels)
 	}
 }
 
+static string lower_ext(const char *ext)
+{
+	string s(ext);
+	for (auto &c : s)
+		c = (char)tolower((unsigned char)c);
+	return s;
+}
+
+struct ImageSequence {
+	string pattern; // printf style, e.g. "shot_%04d.png"
+	int start = 0;
+	int frames = 0;
+};
+
+// group "shot_0001.png", "shot_0002.png"... by prefix and extension. only zero padded numbers are grouped by width,
+// so "f1.png" ... "f100.png" is a single "f%d.png" sequence. image2 stops at a missing number, so a gap starts a new sequence
+static list<ImageSequence> find_image_sequences(const list<string> &names)
+{
+	struct Frame {
+		string prefix;
+		string ext;
+		size_t width;
+		int number;
+	};
+	list<Frame> frames;
+	set<string> padded; // prefix + ext + width of frames with leading 0
+	for (const auto &name : names) {
+		const auto dot = name.rfind('.');
+		if (dot == string::npos)
+			continue;
+		auto begin = dot;
+		while (begin > 0 && name[begin - 1] >= '0' && name[begin - 1] <= '9')
+			--begin;
+		const auto width = dot - begin;
+		if (width == 0 || width > 9)
+			continue;
+		string prefix;
+		for (auto c : name.substr(0, begin)) { // escape for av_get_frame_filename
+			if (c == '%')
+				prefix += '%';
+			prefix += c;
+		}
+		frames.push_back({prefix, name.substr(dot), width, stoi(name.substr(begin, width))});
+		if (width > 1 && name[begin] == '0')
+			padded.insert(prefix + '\0' + frames.back().ext + '\0' + to_string(width));
+	}
+	map<string, pair<string, set<int>>> groups; // key => pattern, numbers
+	for (const auto &f : frames) {
+		auto key = f.prefix + '\0' + f.ext + '\0';
+		string digits = "%d";
+		if (padded.count(key + to_string(f.width))) {
+			key += to_string(f.width);
+			digits = "%0" + to_string(f.width) + "d";
+		}
+		auto &g = groups[key];
+		g.first = f.prefix + digits + f.ext;
+		g.second.insert(f.number);
+	}
+	list<ImageSequence> ret;
+	for (const auto &kv : groups) {
+		const auto &numbers = kv.second.second;
+		list<ImageSequence> runs;
+		for (auto n : numbers) {
+			if (runs.empty() || n != runs.back().start + runs.back().frames)
+				runs.push_back({kv.second.first, n, 0});
+			runs.back().frames++;
+		}
+		if (runs.size() > 1)
+			blog(LOG_WARNING, "image sequence %s has %zu gaps in numbering, split into sequences", kv.second.first.data(), runs.size() - 1);
+		for (const auto &seq : runs) {
+			if (seq.frames > 1) // a single numbered image is not a clip
+				ret.push_back(seq);
+		}
+	}
+	return ret;
+}
+
+template<typename Streams>
+static void add_tracks(obs_property_t *p, const Streams &streams)
+{
+	for (size_t i = 0; i < streams.size(); ++i) {
+		const auto &s = streams[i];
+		string name = "#" + to_string(i) + " " + s.codec.codec;
+		for (auto key : {"language", "title"}) {
+			auto it = s.metadata.find(key);
+			if (it != s.metadata.end())
+				name += " " + it->second;
+		}
+		obs_property_list_add_int(p, name.data(), (long long)i);
+	}
+}
+
 class mdkVideoSource {
 public:
   mdkVideoSource(obs_source_t* src) : source_(src) {
@@ -151,6 +257,17 @@ public:
         const auto codec = player_.mediaInfo().video[0].codec;
         w_ = codec.width;
         h_ = codec.height;
+        const auto &info = player_.mediaInfo();
+        applyTracks(&info); // selection may not exist in this media
+        blog(LOG_INFO, "active tracks: video %s, audio %s, subtitle %s. %d of %zu streams are disabled",
+             track_name(video_track_).data(), track_name(audio_track_).data(), track_name(subtitle_track_).data(),
+             int(info.video.size() + info.audio.size() + info.subtitle.size())
+               - (video_track_ >= 0) - (audio_track_ >= 0) - (subtitle_track_ >= 0),
+             info.video.size() + info.audio.size() + info.subtitle.size());
+        {
+          lock_guard<mutex> lock(media_mtx_);
+          setMediaOptions(next_url_); // current media is opened, safe to change options for the next one
+        }
 	    obs_source_media_started(source_);
       }
       return true;
@@ -163,7 +280,7 @@ public:
 			    return;
 		    next_it_ = urls_.cbegin();
 	    }
-	    player_.setNextMedia(next_it_->data());
+	    setNextMedia(next_it_->data());
 	    std::advance(next_it_, 1);
     });
 
@@ -177,6 +294,8 @@ public:
 	player_.onFrame<AudioFrame>([this](AudioFrame &f, int track) {
 		if (!f || f.timestamp() == TimestampEOS)
 			return 0;
+		if (track != audio_track_) // never mix another language
+			return 0;
 		struct obs_source_audio audio = {};
 		const auto planes = f.planeCount();
 		for (int i = 0; i < planes; i++)
@@ -205,6 +324,18 @@ public:
 	stop_hotkey = obs_hotkey_register_source(source_, "MDKVideoSource.Stop",
 		obs_module_text("Stop"),
 		hotkeyStop, this);
+
+	step_forward_hotkey = obs_hotkey_register_source(
+		source_, "MDKVideoSource.StepForward", obs_module_text("StepForward"),
+		hotkeyStepForward, this);
+
+	step_backward_hotkey = obs_hotkey_register_source(
+		source_, "MDKVideoSource.StepBackward", obs_module_text("StepBackward"),
+		hotkeyStepBackward, this);
+
+	instant_replay_hotkey = obs_hotkey_register_source(
+		source_, "MDKVideoSource.InstantReplay", obs_module_text("InstantReplay"),
+		hotkeyInstantReplay, this);
   }
 
   ~mdkVideoSource() {
@@ -212,27 +343,68 @@ public:
 
     obs_enter_graphics();
     gs_texrender_destroy(texrender_);
+    for (const auto &f : frames_)
+      gs_texture_destroy(f.tex);
+    for (auto t : pool_)
+      gs_texture_destroy(t);
     obs_leave_graphics();
   }
 
   gs_texture_t* render() {
+    lock_guard<mutex> lock(cache_mtx_);
+    if (cached_ >= 0)
+      return renderCached();
     if (!ensureRTV())
       return nullptr;
-    player_.renderVideo();
+    const auto pts = player_.renderVideo();
     gs_texrender_end(texrender_);
+    cacheFrame(pts);
     return tex_;
   }
 
   void play(const char* url) {
     SetGlobalOption("sdr.white", obs_get_video_sdr_white_level());
-    player_.setNextMedia(nullptr);
+    {
+      lock_guard<mutex> lock(cache_mtx_);
+      leaveCache();
+    }
+    setNextMedia(nullptr);
     player_.set(State::Stopped);
     player_.waitFor(State::Stopped);
     player_.setMedia(nullptr); // 1st url may be the same as current url
+    {
+      lock_guard<mutex> lock(media_mtx_);
+      setMediaOptions(url);
+    }
     player_.setMedia(url);
     player_.set(State::Playing);
   }
 
+  // stopped player reopens current url, which requires its avformat options back
+  void setState(State s) {
+    {
+      lock_guard<mutex> lock(cache_mtx_);
+      if (cached_ >= 0) { // player stays paused at the newest cached frame
+        startReplay(s == State::Playing);
+        return;
+      }
+    }
+    if (s != State::Stopped && player_.state() == State::Stopped && player_.url()) {
+      lock_guard<mutex> lock(media_mtx_);
+      setMediaOptions(player_.url());
+    }
+    player_.set(s);
+  }
+
+  void stop() {
+    {
+      lock_guard<mutex> lock(cache_mtx_);
+      leaveCache();
+    }
+    setNextMedia(nullptr);
+    player_.set(State::Stopped);
+  }
+
   void restart() {
     player_.setMedia(nullptr);
     setUrls(urls_, loop_);
@@ -242,11 +414,130 @@ public:
   uint32_t height() const { return h_; }
   uint32_t flip() const { return flip_; }
 
+  // only the selected track of each type is decoded, other streams are disabled in demuxer
+  void setTracks(int video, int audio, int subtitle)
+  {
+	  video_sel_ = video;
+	  audio_sel_ = audio;
+	  subtitle_sel_ = subtitle;
+	  if (test_flag(player_.mediaStatus() & MediaStatus::Loaded))
+		  applyTracks(&player_.mediaInfo());
+	  else
+		  applyTracks(nullptr);
+  }
+
+  void setReplayDuration(int seconds) { replay_ms_ = seconds * 1000; }
+
+  // memory budget of rendered frames kept for backward seeks, steps and replay. 0: disabled
+  void setFrameCacheSize(int mb)
+  {
+	  lock_guard<mutex> lock(cache_mtx_);
+	  cache_bytes_ = size_t(mb) << 20;
+	  if (cache_bytes_ == 0)
+		  leaveCache(); // textures are released in render()
+  }
+
+  int64_t position()
+  {
+	  lock_guard<mutex> lock(cache_mtx_);
+	  if (cached_ >= 0)
+		  return frames_[cached_].ms;
+	  return player_.position();
+  }
+
+  bool isCached(bool *playing)
+  {
+	  lock_guard<mutex> lock(cache_mtx_);
+	  *playing = replaying_;
+	  return cached_ >= 0;
+  }
+
+  void seek(int64_t ms)
+  {
+	  State resume = State::Stopped;
+	  {
+		  lock_guard<mutex> lock(cache_mtx_);
+		  const bool playing = cached_ >= 0 ? replaying_ : player_.state() == State::Playing;
+		  if (seekCached(ms, playing))
+			  return;
+		  if (cached_ >= 0)
+			  resume = playing ? State::Playing : State::Paused;
+		  leaveCache();
+	  }
+	  player_.seek(ms);
+	  if (resume != State::Stopped)
+		  player_.set(resume);
+  }
+
+  void step(int frames)
+  {
+	  {
+		  lock_guard<mutex> lock(cache_mtx_);
+		  const int size = (int)frames_.size();
+		  const int i = (cached_ >= 0 ? cached_ : size - 1) + frames; // the newest cached frame is the live one
+		  if (size > 1 && i >= 0 && i < size) {
+			  if (cached_ < 0)
+				  player_.set(State::Paused);
+			  cached_ = i;
+			  replaying_ = false;
+			  return;
+		  }
+		  if (size > 1 && i < 0) { // before the oldest cached frame. player is at the newest one, so seek to the previous frame
+			  const auto ms = frames_.front().ms - 1;
+			  leaveCache();
+			  player_.set(State::Paused);
+			  player_.seek(std::max<int64_t>(ms, 0), SeekFlag::FromStart);
+			  return;
+		  }
+		  if (cached_ >= 0) { // after the newest cached frame, continue from player. cached frames are still continuous
+			  frames = i - size + 1;
+			  cached_ = -1;
+			  replaying_ = false;
+		  }
+	  }
+	  player_.set(State::Paused);
+	  player_.seek(frames, SeekFlag::FromNow | SeekFlag::Frame); // backward decodes again from the previous key frame
+  }
+
+  void instantReplay()
+  {
+	  int64_t ms = 0;
+	  {
+		  lock_guard<mutex> lock(cache_mtx_);
+		  const auto now = cached_ >= 0 ? frames_[cached_].ms : player_.position();
+		  ms = std::max<int64_t>(now - replay_ms_, 0);
+		  if (seekCached(ms, true))
+			  return;
+		  leaveCache();
+	  }
+	  player_.seek(ms, SeekFlag::FromStart); // accurate, not rounded to the previous key frame
+	  setState(State::Playing);
+  }
+
+  // sequences: url => start number
+  void setImageSequences(const map<string, int> &sequences, double fps)
+  {
+	  string reopen;
+	  {
+		  lock_guard<mutex> lock(media_mtx_);
+		  auto now = player_.url();
+		  if (now && sequences_.count(now)) {
+			  auto it = sequences.find(now);
+			  if (it != sequences.cend() && (fps != sequence_fps_ || it->second != sequences_[now]))
+				  reopen = now;
+		  }
+		  sequences_ = sequences;
+		  sequence_fps_ = fps;
+	  }
+	  if (!reopen.empty()) // options are applied when opening
+		  play(reopen.data());
+  }
+
   void setUrls(const list<string> &urls, bool loop)
   {
 	  loop_ = loop;
 	  urls_ = urls;
-	  player_.setNextMedia(nullptr);
+	  setNextMedia(nullptr);
       if (urls_.empty()) {
 	    player_.set(State::Stopped);
         return;
@@ -264,12 +555,12 @@ public:
 	  next_it_ = ++it;
     if (it == urls_.cend()) {
 		  if (!loop_) {
-			  player_.setNextMedia(nullptr);
+			  setNextMedia(nullptr);
 			  return;
 		  }
 		  next_it_ = urls_.cbegin();
 	  }
-	  player_.setNextMedia(next_it_->data());
+	  setNextMedia(next_it_->data());
   }
 
   Player player_;
@@ -279,6 +570,147 @@ private:
 #endif
   gs_color_space cs_ = GS_CS_SRGB;
 
+  void setNextMedia(const char *url)
+  {
+	  player_.setNextMedia(url);
+	  lock_guard<mutex> lock(media_mtx_);
+	  next_url_ = url ? url : "";
+	  if (test_flag(player_.mediaStatus() & MediaStatus::Loaded)) // otherwise applied when current media is loaded
+		  setMediaOptions(next_url_);
+  }
+
+  // avformat options are player wide, so set them for each url right before it's opened. requires media_mtx_
+  void setMediaOptions(const string &url)
+  {
+	  auto it = sequences_.find(url);
+	  if (it == sequences_.cend()) {
+		  if (!sequence_options_)
+			  return;
+		  // ffmpeg defaults. framerate is also an option of raw video demuxers(h264, mpegvideo...)
+		  player_.setProperty("avformat.framerate", "25");
+		  player_.setProperty("avformat.start_number", "0");
+		  sequence_options_ = false;
+		  return;
+	  }
+	  player_.setProperty("avformat.framerate", to_string(sequence_fps_));
+	  player_.setProperty("avformat.start_number", to_string(it->second)); // no probing from 0 on every loop
+	  sequence_options_ = true;
+  }
+
+  struct CachedFrame {
+	  gs_texture_t *tex;
+	  int64_t ms; // timestamp of rendered frame
+  };
+
+  // requires cache_mtx_ and graphics context
+  void cacheFrame(double pts)
+  {
+	  if (cache_bytes_ == 0) {
+		  for (auto t : pool_)
+			  gs_texture_destroy(t);
+		  pool_.clear();
+		  return;
+	  }
+	  if (pts < 0 || !tex_)
+		  return;
+	  const auto ms = int64_t(pts * 1000.0);
+	  if (!frames_.empty()) {
+		  if (ms == frames_.back().ms) // paused or rendered again
+			  return;
+		  if (ms < frames_.back().ms) // seek, loop or next media. cached frames must be continuous
+			  dropFrames();
+	  }
+	  const auto format = gs_texture_get_color_format(tex_);
+	  if (format != frame_format_ || w_ != frame_w_ || h_ != frame_h_) { // pool holds textures of a single size and format
+		  dropFrames();
+		  for (auto t : pool_)
+			  gs_texture_destroy(t);
+		  pool_.clear();
+		  frame_format_ = format;
+		  frame_w_ = w_;
+		  frame_h_ = h_;
+	  }
+	  const size_t frame_bytes = size_t(w_) * h_ * gs_get_format_bpp(format) / 8;
+	  if (frame_bytes == 0)
+		  return;
+	  const size_t max_frames = cache_bytes_ / frame_bytes;
+	  while (!frames_.empty() && frames_.size() >= max_frames) {
+		  pool_.push_back(frames_.front().tex);
+		  frames_.pop_front();
+	  }
+	  while (!pool_.empty() && frames_.size() + pool_.size() > max_frames) { // budget is reduced
+		  gs_texture_destroy(pool_.back());
+		  pool_.pop_back();
+	  }
+	  if (max_frames < 2)
+		  return;
+	  gs_texture_t *t = nullptr;
+	  if (pool_.empty()) {
+		  t = gs_texture_create(w_, h_, format, 1, nullptr, 0);
+	  } else {
+		  t = pool_.back();
+		  pool_.pop_back();
+	  }
+	  if (!t)
+		  return;
+	  gs_copy_texture(t, tex_);
+	  frames_.push_back({t, ms});
+  }
+
+  // requires cache_mtx_
+  gs_texture_t *renderCached()
+  {
+	  if (replaying_) {
+		  const auto ms = replay_ms0_ + int64_t(double(os_gettime_ns() - replay_ns0_) / 1000000.0 * player_.playbackRate());
+		  while (cached_ + 1 < (int)frames_.size() && frames_[cached_ + 1].ms <= ms)
+			  ++cached_;
+		  if (cached_ + 1 == (int)frames_.size()) { // caught up, player continues from the newest frame
+			  cached_ = -1;
+			  replaying_ = false;
+			  player_.set(State::Playing);
+			  return frames_.back().tex;
+		  }
+	  }
+	  return frames_[cached_].tex;
+  }
+
+  // requires cache_mtx_
+  void startReplay(bool play)
+  {
+	  replaying_ = play;
+	  replay_ms0_ = frames_[cached_].ms;
+	  replay_ns0_ = os_gettime_ns();
+  }
+
+  // requires cache_mtx_. serve ms from cached frames if possible, player is paused at the newest frame meanwhile
+  bool seekCached(int64_t ms, bool play)
+  {
+	  if (frames_.size() < 2 || ms < frames_.front().ms || ms > frames_.back().ms)
+		  return false;
+	  auto it = upper_bound(frames_.cbegin(), frames_.cend(), ms, [](int64_t v, const CachedFrame &f) { return v < f.ms; });
+	  if (cached_ < 0)
+		  player_.set(State::Paused);
+	  cached_ = int(it - frames_.cbegin()) - 1;
+	  startReplay(play);
+	  return true;
+  }
+
+  // requires cache_mtx_. textures are reused by cacheFrame()
+  void dropFrames()
+  {
+	  for (const auto &f : frames_)
+		  pool_.push_back(f.tex);
+	  frames_.clear();
+  }
+
+  // requires cache_mtx_. back to player output
+  void leaveCache()
+  {
+	  cached_ = -1;
+	  replaying_ = false;
+	  dropFrames();
+  }
+
   bool ensureRTV() {
     if (w_ <= 0 || h_ <= 0)
       return false;
@@ -357,7 +789,72 @@ private:
 		  obs_source_media_stop(c->source_);
   }
 
+  static string track_name(int track) { return track < 0 ? string("none") : "#" + to_string(track); }
+
+  // info: loaded media to check the selection against, null if not loaded
+  void applyTracks(const MediaInfo *info)
+  {
+	  auto apply = [this, info](MediaType type, const char *name, int track, size_t count) {
+		  if (track == kTrackAuto)
+			  track = 0;
+		  if (info && track >= (int)count) {
+			  if (count == 0) // nothing to decode, keep the selection for the next media
+				  return kTrackNone;
+			  blog(LOG_WARNING, "%s track #%d does not exist in %s, fallback to #0", name, track, player_.url());
+			  track = 0;
+		  }
+		  set<int> tracks;
+		  if (track >= 0)
+			  tracks.insert(track);
+		  player_.setActiveTracks(type, tracks);
+		  return track;
+	  };
+	  video_track_ = apply(MediaType::Video, "video", video_sel_, info ? info->video.size() : 0);
+	  audio_track_ = apply(MediaType::Audio, "audio", audio_sel_, info ? info->audio.size() : 0);
+	  subtitle_track_ = apply(MediaType::Subtitle, "subtitle", subtitle_sel_, info ? info->subtitle.size() : 0);
+  }
+
+  static void hotkeyStepForward(void *data, obs_hotkey_id, obs_hotkey_t *, bool pressed)
+  {
+	  auto c = static_cast<mdkVideoSource *>(data);
+	  if (pressed && obs_source_active(c->source_))
+		  c->step(1);
+  }
+
+  static void hotkeyStepBackward(void *data, obs_hotkey_id, obs_hotkey_t *, bool pressed)
+  {
+	  auto c = static_cast<mdkVideoSource *>(data);
+	  if (pressed && obs_source_active(c->source_))
+		  c->step(-1);
+  }
+
+  static void hotkeyInstantReplay(void *data, obs_hotkey_id, obs_hotkey_t *, bool pressed)
+  {
+	  auto c = static_cast<mdkVideoSource *>(data);
+	  if (pressed && obs_source_active(c->source_))
+		  c->instantReplay();
+  }
+
   bool loop_ = true;
+  atomic<int> replay_ms_{0};
+
+  mutex cache_mtx_;
+  size_t cache_bytes_ = 0;
+  deque<CachedFrame> frames_; // continuous, oldest first
+  vector<gs_texture_t*> pool_;
+  gs_color_format frame_format_ = GS_UNKNOWN;
+  uint32_t frame_w_ = 0;
+  uint32_t frame_h_ = 0;
+  int cached_ = -1; // index of frame shown instead of player output
+  bool replaying_ = false;
+  int64_t replay_ms0_ = 0;
+  uint64_t replay_ns0_ = 0;
+  atomic<int> video_sel_{kTrackAuto}; // settings
+  atomic<int> audio_sel_{kTrackAuto};
+  atomic<int> subtitle_sel_{kTrackAuto};
+  atomic<int> video_track_{0}; // active in current media
+  atomic<int> audio_track_{0};
+  atomic<int> subtitle_track_{0};
 
   obs_source_t *source_ = nullptr;
   gs_texture_t *tex_ = nullptr;
@@ -372,6 +869,15 @@ private:
   obs_hotkey_id stop_hotkey;
   obs_hotkey_id playlist_next_hotkey;
   obs_hotkey_id playlist_prev_hotkey;
+  obs_hotkey_id step_forward_hotkey;
+  obs_hotkey_id step_backward_hotkey;
+  obs_hotkey_id instant_replay_hotkey;
+
+  mutex media_mtx_;
+  map<string, int> sequences_;
+  double sequence_fps_ = 0;
+  bool sequence_options_ = false;
+  string next_url_;
 
   mutable list<string>::const_iterator next_it_;
   list<string> urls_;
@@ -420,27 +926,56 @@ static void mdkvideo_update(void* data, obs_data_t* settings)
   decs.insert(decs.end(), { "hap", "FFmpeg", "dav1d" });
   obj->player_.setDecoders(MediaType::Video, decs);
 
+  obj->setReplayDuration((int)obs_data_get_int(settings, "replay_seconds"));
+  obj->setFrameCacheSize((int)obs_data_get_int(settings, "frame_cache_mb"));
+
+  obj->setTracks((int)obs_data_get_int(settings, "video_track"),
+                 (int)obs_data_get_int(settings, "audio_track"),
+                 (int)obs_data_get_int(settings, "subtitle_track"));
+
   auto urls = obs_data_get_array(settings, S_PLAYLIST);
   auto nb_urls = obs_data_array_count(urls);
   list<string> new_urls;
+  map<string, int> sequences;
   for (size_t i = 0; i < nb_urls; i++) {
 		obs_data_t *item = obs_data_array_item(urls, i);
 		string p = obs_data_get_string(item, "value");
 		auto dir = os_opendir(p.data());
 		if (dir) {
+			list<string> images;
+			bool has_media = false;
 			for (auto ent = os_readdir(dir); ent; ent = os_readdir(dir)) {
 				if (ent->directory)
 					continue;
 				auto ext = os_get_path_extension(ent->d_name);
-				if (strstr(EXTENSIONS_MEDIA, ext))
+				if (!ext)
+					continue;
+				if (strstr(EXTENSIONS_MEDIA, ext)) {
 					new_urls.push_back(p + "/" + ent->d_name);
+					has_media = true;
+				} else if (strstr(EXTENSIONS_IMAGE, lower_ext(ext).data())) { // SHOT_0001.PNG from export tools
+					images.push_back(ent->d_name);
+				}
 			}
 			os_closedir(dir);
+			if (!has_media) {
+				string escaped_dir;
+				for (auto c : p) {
+					if (c == '%')
+						escaped_dir += '%';
+					escaped_dir += c;
+				}
+				for (const auto &seq : find_image_sequences(images)) {
+					new_urls.push_back(escaped_dir + "/" + seq.pattern);
+					sequences[new_urls.back()] = seq.start;
+				}
+			}
 		} else {
 			new_urls.push_back(p);
 		}
 		obs_data_release(item);
 	}
+	obj->setImageSequences(sequences, obs_data_get_double(settings, "image_sequence_fps"));
 	obj->setUrls(new_urls, loop);
 }
 
@@ -474,9 +1009,15 @@ static void mdkvideo_defaults(obs_data_t* settings)
   obs_data_set_default_bool(settings, "looping", true);
   obs_data_set_default_int(settings, "speed_percent", 100);
   obs_data_set_default_int(settings, "device", -1);
+  obs_data_set_default_double(settings, "image_sequence_fps", 30.0);
+  obs_data_set_default_int(settings, "video_track", kTrackAuto);
+  obs_data_set_default_int(settings, "audio_track", kTrackAuto);
+  obs_data_set_default_int(settings, "subtitle_track", kTrackAuto);
+  obs_data_set_default_int(settings, "replay_seconds", 5);
+  obs_data_set_default_int(settings, "frame_cache_mb", 0);
 }
 
-static obs_properties_t* mdkvideo_properties(void*)
+static obs_properties_t* mdkvideo_properties(void* data)
 {
   auto* props = obs_properties_create();
   obs_property_t* p = nullptr;
@@ -525,6 +1066,35 @@ static obs_properties_t* mdkvideo_properties(void*)
   obs_properties_add_bool(props, "looping", obs_module_text("Looping"));
   auto prop = obs_properties_add_int_slider(props, "speed_percent", obs_module_text("SpeedPercentage"), 1, kMaxSpeedPercent, 1);
   obs_property_int_set_suffix(prop, "%");
+  prop = obs_properties_add_float(props, "image_sequence_fps", obs_module_text("ImageSequenceFPS"), 1.0, 240.0, 0.001);
+  obs_property_set_long_description(prop, obs_module_text("ImageSequenceFPS.Description"));
+
+  prop = obs_properties_add_int_slider(props, "frame_cache_mb", obs_module_text("FrameCache"), 0, kMaxFrameCacheMB, 64);
+  obs_property_int_set_suffix(prop, " MB");
+  obs_property_set_long_description(prop, obs_module_text("FrameCache.Description"));
+  prop = obs_properties_add_int_slider(props, "replay_seconds", obs_module_text("InstantReplaySeconds"), 1, kMaxReplaySeconds, 1);
+  obs_property_int_set_suffix(prop, " s");
+  obs_property_set_long_description(prop, obs_module_text("InstantReplaySeconds.Description"));
+
+  // tracks of current media
+  auto obj = static_cast<mdkVideoSource*>(data);
+  const char* track_props[] = { "video_track", "audio_track", "subtitle_track" };
+  const char* track_texts[] = { "VideoTrack", "AudioTrack", "SubtitleTrack" };
+  for (int i = 0; i < 3; ++i) {
+    p = obs_properties_add_list(props, track_props[i], obs_module_text(track_texts[i]), OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_INT);
+    obs_property_set_long_description(p, obs_module_text("Track.Description"));
+    obs_property_list_add_int(p, obs_module_text("Auto"), kTrackAuto);
+    obs_property_list_add_int(p, obs_module_text("None"), kTrackNone);
+    if (!obj)
+      continue;
+    const auto &info = obj->player_.mediaInfo();
+    if (i == 0)
+      add_tracks(p, info.video);
+    else if (i == 1)
+      add_tracks(p, info.audio);
+    else
+      add_tracks(p, info.subtitle);
+  }
 
   auto filters = string("MediaFiles (") + EXTENSIONS_MEDIA + ")";
   obs_properties_add_editable_list(props, S_PLAYLIST, T_PLAYLIST,
@@ -575,14 +1145,13 @@ static void mdkvideo_render(void* data, gs_effect_t* effect)
 static void mdkvideo_play_pause(void *data, bool pause)
 {
 	auto obj = static_cast<mdkVideoSource *>(data);
-	obj->player_.set(pause ? State::Paused : State::Playing);
+	obj->setState(pause ? State::Paused : State::Playing);
 }
 
 static void mdkvideo_stop(void *data)
 {
 	auto obj = static_cast<mdkVideoSource *>(data);
-	obj->player_.setNextMedia(nullptr);
-	obj->player_.set(State::Stopped);
+	obj->stop();
 }
 
 static void mdkvideo_restart(void *data)
@@ -601,18 +1170,21 @@ static int64_t mdkvideo_get_duration(void *data)
 static int64_t mdkvideo_get_time(void *data)
 {
 	auto obj = static_cast<mdkVideoSource *>(data);
-	return obj->player_.position();
+	return obj->position();
 }
 
 static void mdkvideo_set_time(void *data, int64_t ms)
 {
 	auto obj = static_cast<mdkVideoSource *>(data);
-	obj->player_.seek(ms);
+	obj->seek(ms);
 }
 
 static enum obs_media_state mdkvideo_get_state(void *data)
 {
 	auto obj = static_cast<mdkVideoSource *>(data);
+	bool playing = false;
+	if (obj->isCached(&playing))
+		return playing ? OBS_MEDIA_STATE_PLAYING : OBS_MEDIA_STATE_PAUSED;
 	auto s = obj->player_.mediaStatus();
 	if (test_flag(s & MediaStatus::Loading))
 		return OBS_MEDIA_STATE_OPENING;